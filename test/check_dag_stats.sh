@@ -0,0 +1,97 @@
+#!/bin/sh
+#
+# Check the split detection of dag_stats.awk against the hand-captured dumps
+# (min and pmul stay vectorized: smin -> PMINSWrr, pmuludq) and against small
+# DAGs where a v4i32 mul is unrolled into scalar muls: by the passes between
+# the combine1 and legalize inputs, by instruction selection, or already in
+# the hoisted IR.
+
+cd "$(dirname "$0")"
+status=0
+
+# section <table> <report>: the lines of one table of the report.
+section() {
+        echo "$2" | awk -v t="$1" '$1 == t && $2 == "nodes" { p = 1 } p; p && /split:/ { exit }'
+}
+
+expect() {
+        if ! echo "$2" | grep -q -F "$3"; then
+                echo "$1: expected '$3', got:" >&2
+                echo "$2" >&2
+                status=1
+        fi
+}
+
+out=$(awk -f dag_stats.awk min.dag*.dot)
+expect min "$(section hoisted "$out")" 'first split: none'
+out=$(awk -f dag_stats.awk pmul.dag*.dot)
+expect pmul "$(section hoisted "$out")" 'first split: none'
+
+tmp=$(mktemp -d)
+# node <id> <opcode> <type> [<operand id> ...]
+node() {
+        id=$1 op=$2 type=$3
+        shift 3
+        echo "	Node0x$id [shape=record,shape=Mrecord,label=\"{{<s0>0|<s1>1}|$op [ID=$id]|0x$id|{<d0>$type}}\"];"
+        s=0
+        for operand; do
+                echo "	Node0x$id:s$s -> Node0x$operand:d0;"
+                s=$((s + 1))
+        done
+}
+# graph <title>: wrap the nodes read from stdin.
+graph() {
+        echo "digraph \"$1 input for main:\" {"
+        echo "	label=\"$1 input for main:\";"
+        echo
+        cat
+        echo "}"
+}
+vector_mul() {
+        node 1 load v4i32; node 2 load v4i32; node 3 $1 v4i32 1 2
+        node 4 extract_vector_elt i32 3
+}
+scalar_mul() {
+        node 1 load v4i32; node 2 load v4i32
+        for i in 1 2 3 4; do
+                node a$i $1 i32 1; node b$i $1 i32 2; node c$i $2 i32 a$i b$i
+        done
+        node 5 $3 v4i32 c1 c2 c3 c4; node 6 $1 i32 5
+}
+vector_mul mul | graph dag-combine1 > $tmp/base.dag1.combine1.dot
+vector_mul mul | graph legalize > $tmp/base.dag2.legalize.dot
+scalar_mul extract_vector_elt mul BUILD_VECTOR | graph legalize > $tmp/split.dag2.legalize.dot
+
+# Split by the passes between the combine1 and legalize inputs.
+mkdir $tmp/legalize
+cp $tmp/base.dag1.combine1.dot $tmp/legalize/k_original.dag1.combine1.dot
+cp $tmp/base.dag2.legalize.dot $tmp/legalize/k_original.dag2.legalize.dot
+cp $tmp/base.dag1.combine1.dot $tmp/legalize/k.dag1.combine1.dot
+cp $tmp/split.dag2.legalize.dot $tmp/legalize/k.dag2.legalize.dot
+out=$(awk -f dag_stats.awk $tmp/legalize/*.dot)
+expect legalize "$(section original "$out")" 'first split: none'
+expect legalize "$(section hoisted "$out")" \
+        'first split: between combine1 input and legalize input (dag-combine1 / LegalizeTypes / LegalizeVectors)'
+expect legalize "$(section delta "$out")" 'hoisted split: between combine1 input and legalize input'
+
+# Hoisted IR is already scalar: not SelectionDAG's doing.
+mkdir $tmp/ir
+cp $tmp/base.dag1.combine1.dot $tmp/ir/k_original.dag1.combine1.dot
+cp $tmp/base.dag2.legalize.dot $tmp/ir/k_original.dag2.legalize.dot
+scalar_mul extract_vector_elt mul BUILD_VECTOR | graph dag-combine1 > $tmp/ir/k.dag1.combine1.dot
+cp $tmp/split.dag2.legalize.dot $tmp/ir/k.dag2.legalize.dot
+out=$(awk -f dag_stats.awk $tmp/ir/*.dot)
+expect ir "$(section hoisted "$out")" 'first split: none'
+expect ir "$(section delta "$out")" 'hoisted IR: already split before SelectionDAG'
+expect ir "$(section delta "$out")" 'hoisted split: none'
+
+# Split by instruction selection.
+mkdir $tmp/isel
+vector_mul mul | graph isel > $tmp/isel/k.dag4.isel.dot
+scalar_mul PEXTRDrr IMUL32rr PINSRDrr | graph scheduler > $tmp/isel/k.dag5.sched.dot
+out=$(awk -f dag_stats.awk $tmp/isel/*.dot)
+expect isel "$(section hoisted "$out")" \
+        'first split: between isel input and sched input (instruction selection)'
+
+rm -rf $tmp
+exit $status
@@ -0,0 +1,87 @@
+#!/bin/sh
+#
+# Report where SelectionDAG splits vector code, for the original and the
+# hoisted IR of every kernel (run make_all.sh first to produce the .ll files).
+#
+# Usage: ./dag_report.sh [kernel ...]    (default: every *.c with IR)
+#
+# The per-stage DAGs are dumped with llc -view-*-dags, which only exists in
+# LLVM builds with assertions enabled. Set LLC to pick a different llc. The
+# dumps are kept under $DAG_DIR (default: ../build/dags) as
+# <kernel>[_original].dagN.<stage>.<function>.<block>.dot; the entry block
+# has no name and is written as <function>.dot.
+
+TEST_DIR=$(cd "$(dirname "$0")" && pwd)
+
+LLC=$(command -v "${LLC:-llc}")
+if [ -z "$LLC" ] || ! "$LLC" -help-hidden | grep -q -- '-view-isel-dags'; then
+        echo "llc does not support -view-*-dags (needs an LLVM build with assertions)" >&2
+        exit 1
+fi
+
+DAG_DIR=${DAG_DIR:-$TEST_DIR/../build/dags}
+mkdir -p "$DAG_DIR" && DAG_DIR=$(cd "$DAG_DIR" && pwd) || exit 1
+if [ "$DAG_DIR" = "$TEST_DIR" ]; then
+        echo "DAG_DIR must not be the test directory (it holds the hand-captured dumps)" >&2
+        exit 1
+fi
+
+cd "$TEST_DIR"
+if [ $# -eq 0 ]; then
+        set -- $(ls *.c | sed 's/\.c$//')
+fi
+
+status=0
+for kernel in "$@"; do
+        for ll in ${kernel}_original.ll ${kernel}.ll; do
+                if [ ! -f $ll ]; then
+                        echo "$ll: missing, skipped" >&2
+                        continue
+                fi
+                base=${ll%.ll}
+                rm -f "$DAG_DIR"/$base.dag*.dot
+                tmp=$(mktemp -d)
+                # llc writes each graph to $TMPDIR and then tries to open a
+                # viewer; an empty PATH makes it leave the file alone. Its
+                # "Writing ..." chatter goes to the log.
+                if ! env PATH=/nonexistent TMPDIR=$tmp "$LLC" \
+                        -view-dag-combine1-dags -view-legalize-dags \
+                        -view-dag-combine2-dags -view-isel-dags -view-sched-dags \
+                        $ll -o /dev/null 2>$tmp/llc.log; then
+                        echo "$ll: llc failed" >&2
+                        grep -v -e '^Writing ' -e "^Trying '" -e '^Remember to erase' \
+                                -e ' done\.$' $tmp/llc.log >&2
+                        rm -rf $tmp
+                        status=1
+                        continue
+                fi
+                # Oldest first, so that unnamed blocks are numbered in the
+                # order llc visited them.
+                for dot in $(ls -tr $tmp/*.dot 2>/dev/null); do
+                        title=$(grep -m1 'label="' $dot | sed 's/^[^"]*"//; s/";*$//')
+                        case $title in
+                                'dag-combine1 input'*) stage=dag1.combine1 ;;
+                                'legalize input'*)     stage=dag2.legalize ;;
+                                'dag-combine2 input'*) stage=dag3.combine2 ;;
+                                'isel input'*)         stage=dag4.isel ;;
+                                'scheduler input'*)    stage=dag5.sched ;;
+                                *) continue ;;
+                        esac
+                        # "<stage> input for <function>:<block>"
+                        block=$(echo "${title#* input for }" |
+                                sed 's/:$//; s/:/./; s/[^A-Za-z0-9_.-]/_/g')
+                        out="$DAG_DIR"/$base.$stage.$block
+                        n=1
+                        while [ -f "$out.dot" ]; do
+                                out="$DAG_DIR"/$base.$stage.$block.$n
+                                n=$((n + 1))
+                        done
+                        mv $dot "$out.dot"
+                done
+                rm -rf $tmp
+        done
+        dots=$(ls "$DAG_DIR"/$kernel.dag*.dot "$DAG_DIR"/${kernel}_original.dag*.dot 2>/dev/null)
+        awk -f dag_stats.awk -v name=$kernel $dots /dev/null
+        echo
+done
+exit $status
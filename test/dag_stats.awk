@@ -0,0 +1,270 @@
+# Summarize SelectionDAG DOT dumps (as written by llc -view-*-dags).
+#
+# Usage: awk -f dag_stats.awk [-v name=<title>] stage1.dot stage2.dot ...
+#
+# Each input is one DAG graph; graphs of the same stage (one per basic
+# block) are added up. -view-<stage>-dags shows the *input* of that stage,
+# so the stages are reported in pipeline order as: combine1, legalize,
+# combine2, isel, sched inputs. Files named *_original.* are the original
+# IR, all others the hoisted IR; each gets its own table.
+#
+# A node counts as "vector" if any of its result values is a vector type
+# (v4i32, v2f64, ...), and as "scalar" if it only produces integer or FP
+# scalars. Chain/glue/untyped-only nodes are counted in the total only.
+# "vec%" is vector / (vector + scalar); the delta table shows the change in
+# percentage points.
+#
+# "vops" are the vector nodes that compute something, i.e. everything but
+# loads, bitcasts, element inserts and shuffles: these are the nodes that
+# implement the kernel's operation. The sched input only holds machine
+# opcodes, so there vops are counted by type instead: vector nodes with a
+# vector operand (copies and bitcasts aside). The isel input is counted the
+# same way for the isel -> sched comparison.
+#
+# "extract" counts scalar nodes that read a vector operand: extract_vector_elt
+# before isel, PEXTRW, MOVPDI2DI, ... after.
+#
+# A vector op that gets scalarized turns into element-typed ops fed by
+# extracts, so a split happened between two consecutive dumps when vops go
+# down while extracts go up. It is reported with the passes that ran in
+# between.
+#
+# With both variants, the per-stage difference (hoisted - original) is
+# printed too, and the same rule is applied to it. Setup code such as
+# _mm_set_* is the same in both and cancels out. A difference that already
+# exists in the combine1 input comes from the IR, not from SelectionDAG.
+
+function stage_of(title) {
+	if (title ~ /^dag-combine1 input/) return "combine1"
+	if (title ~ /^legalize input/)     return "legalize"
+	if (title ~ /^dag-combine2 input/) return "combine2"
+	if (title ~ /^isel input/)         return "isel"
+	if (title ~ /^scheduler input/)    return "sched"
+	return ""
+}
+
+function is_data_movement(op) {
+	return op ~ /^(load|store|bitcast|undef|Constant|ConstantFP|CopyFromReg|CopyToReg)([^A-Za-z]|$)/ ||
+	       op ~ /^(BUILD_VECTOR|insert_vector_elt|extract_vector_elt|scalar_to_vector|vector_shuffle)$/ ||
+	       op ~ /^(concat_vectors|extract_subvector|insert_subvector)$/ ||
+	       op ~ /^X86ISD::(UNPCK|PSHUF|SHUFP|MOV|BLENDI|PALIGNR|VZEXT_MOVL|Wrapper)/
+}
+
+function is_copy(op) {
+	return op ~ /^(bitcast|CopyFromReg|CopyToReg|COPY_TO_REGCLASS|INSERT_SUBREG|EXTRACT_SUBREG|SUBREG_TO_REG|IMPLICIT_DEF)$/
+}
+
+# Count the nodes of the graph just read, now that all result types are
+# known (edges are written right after their user, before the operand).
+function finish_graph(    id, e, vec_operand) {
+	if (stage == "")
+		return
+	for (e = 1; e <= nedges; e++)
+		if (type_of[edge_to[e]] ~ /^v[0-9]+[if][0-9]+$/)
+			vec_operand[edge_from[e]] = 1
+	for (id in vec_operand) {
+		if (res_of[id] == "scalar")
+			extract[key]++
+		else if (res_of[id] == "vector" && !is_copy(op_of[id]))
+			tvops[key]++
+	}
+	delete op_of
+	delete res_of
+	delete type_of
+	nedges = 0
+}
+
+# vops as compared between stage s and the stage before it.
+function ops(var, s, prev) {
+	return (s == "sched" ? tvops[var, prev] : vops[var, prev]) + 0
+}
+
+function ops_at(var, s) {
+	return (s == "sched" ? tvops[var, s] : vops[var, s]) + 0
+}
+
+function interval(prev, s,    i, p, in_range) {
+	p = ""
+	in_range = 0
+	for (i = 1; i <= nstages; i++) {
+		if (order[i] == prev) {
+			in_range = 1
+			continue
+		}
+		if (in_range)
+			p = p (p == "" ? "" : " / ") passes[order[i]]
+		if (order[i] == s)
+			break
+	}
+	return "between " title[prev] " and " title[s] " (" p ")"
+}
+
+function ratio(v, sc) {
+	return (v + sc) > 0 ? 100.0 * v / (v + sc) : 0
+}
+
+function row(label, n, v, sc, vo, ex, r) {
+	if (r == "")
+		r = (v + sc) > 0 ? sprintf("%.1f%%", ratio(v, sc)) : "-"
+	printf "  %-10s %7d %7d %7d %7s %7d %7d\n", label, n, v, sc, r, vo, ex
+}
+
+function header(label) {
+	printf "  %-10s %7s %7s %7s %7s %7s %7s\n", label, "nodes", "vector", "scalar", "vec%", "vops", "extract"
+}
+
+function table(var,    i, s, k, prev, split_at) {
+	header(var)
+	split_at = ""
+	prev = ""
+	for (i = 1; i <= nstages; i++) {
+		s = order[i]
+		k = var SUBSEP s
+		if (!(k in seen))
+			continue
+		row(s, nodes[k], vector[k], scalar[k], ops_at(var, s), extract[k])
+		if (prev != "" && split_at == "" &&
+		    ops_at(var, s) < ops(var, s, prev) && extract[k] + 0 > extract[var, prev] + 0)
+			split_at = interval(prev, s)
+		prev = s
+	}
+	if (("" var SUBSEP "sched") in seen)
+		print "  (sched vops: vector nodes with a vector operand; isel counted so: " tvops[var, "isel"] + 0 ")"
+	print "  first split: " (split_at != "" ? split_at : "none")
+}
+
+function delta(    i, s, h, o, prev, dv, de, pdv, pde, split_at, ir_level) {
+	header("delta")
+	split_at = ""
+	ir_level = 0
+	prev = ""
+	for (i = 1; i <= nstages; i++) {
+		s = order[i]
+		h = "hoisted" SUBSEP s
+		o = "original" SUBSEP s
+		if (!(h in seen) || !(o in seen))
+			continue
+		dv = ops_at("hoisted", s) - ops_at("original", s)
+		de = extract[h] - extract[o]
+		row(s, nodes[h] - nodes[o], vector[h] - vector[o], scalar[h] - scalar[o], dv, de,
+		    sprintf("%+.1f", ratio(vector[h], scalar[h]) - ratio(vector[o], scalar[o])))
+		if (prev == "") {
+			if (s == "combine1" && dv < 0 && de > 0)
+				ir_level = 1
+		} else if (split_at == "") {
+			pdv = ops("hoisted", s, prev) - ops("original", s, prev)
+			pde = extract["hoisted", prev] - extract["original", prev]
+			if (dv < pdv && de > pde)
+				split_at = interval(prev, s)
+		}
+		prev = s
+	}
+	if (ir_level)
+		print "  hoisted IR: already split before SelectionDAG (fewer vops, more extracts at combine1 input)"
+	print "  hoisted split: " (split_at != "" ? split_at : "none")
+}
+
+BEGIN {
+	split("combine1 legalize combine2 isel sched", order, " ")
+	nstages = 5
+	title["combine1"] = "combine1 input"
+	title["legalize"] = "legalize input"
+	title["combine2"] = "combine2 input"
+	title["isel"]     = "isel input"
+	title["sched"]    = "sched input"
+	# Passes that run before the given stage's input is dumped.
+	passes["legalize"] = "dag-combine1 / LegalizeTypes / LegalizeVectors"
+	passes["combine2"] = "Legalize"
+	passes["isel"]     = "dag-combine2"
+	passes["sched"]    = "instruction selection"
+	stage = ""
+}
+
+FNR == 1 {
+	finish_graph()
+	stage = ""
+	base = FILENAME
+	sub(/.*\//, "", base)
+	variant = base ~ /_original\./ ? "original" : "hoisted"
+}
+
+# Graph title, e.g.: label="legalize input for main:";
+/^[ \t]*label="/ && stage == "" {
+	t = $0
+	sub(/^[ \t]*label="/, "", t)
+	stage = stage_of(t)
+	if (stage != "") {
+		key = variant SUBSEP stage
+		seen[key] = 1
+		variants[variant] = 1
+	}
+	next
+}
+
+# Node, e.g.: Node0x.. [...,label="{{<s0>0|<s1>1}|add [ID=7]|0x..|{<d0>v4i32}}"];
+stage != "" && /^[ \t]*Node0x[0-9a-f]+ \[/ {
+	nodes[key]++
+	id = $1
+
+	# The opcode follows the (optional) operand group of the label.
+	op = $0
+	sub(/^[^"]*label="\{(\{[^}]*\}\|)?/, "", op)
+	sub(/[ |].*/, "", op)
+	op_of[id] = op
+
+	# The result types are the last "{<d0>..|<d1>..}" group of the label.
+	types = $0
+	sub(/}}"\];[ \t]*$/, "", types)
+	sub(/.*\{</, "<", types)
+	n = split(types, vt, "|")
+	has_vector = 0
+	has_scalar = 0
+	for (i = 1; i <= n; i++) {
+		t = vt[i]
+		d = t
+		sub(/^<d/, "", d)
+		sub(/>.*/, "", d)
+		sub(/^<d[0-9]+>/, "", t)
+		type_of[id ":d" d] = t
+		if (t ~ /^v[0-9]+[if][0-9]+$/)
+			has_vector = 1
+		else if (t ~ /^([if][0-9]+|ppcf128)$/)
+			has_scalar = 1
+	}
+	if (has_vector) {
+		vector[key]++
+		res_of[id] = "vector"
+		if (!is_data_movement(op))
+			vops[key]++
+	} else if (has_scalar) {
+		scalar[key]++
+		res_of[id] = "scalar"
+	}
+	next
+}
+
+# Operand edge, e.g.: Node0xA:s1 -> Node0xB:d0;
+stage != "" && /^[ \t]*Node0x[0-9a-f]+:s[0-9]+ -> Node0x[0-9a-f]+:d[0-9]+/ {
+	user = $1
+	sub(/:.*/, "", user)
+	used = $3
+	sub(/[;[].*/, "", used)
+	edge_from[++nedges] = user
+	edge_to[nedges] = used
+}
+
+END {
+	finish_graph()
+	if (name != "")
+		print name
+	if (!("hoisted" in variants) && !("original" in variants)) {
+		print "  (no SelectionDAG dumps found)"
+		exit
+	}
+	if ("original" in variants)
+		table("original")
+	if ("hoisted" in variants)
+		table("hoisted")
+	if (("original" in variants) && ("hoisted" in variants))
+		delta()
+}